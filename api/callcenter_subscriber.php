@@ -0,0 +1,37 @@
+<?php
+chdir(__DIR__);
+
+/**
+Long running mod_callcenter event subscriber
+
+Run from the command line (supervisord, systemd, etc) next to the API:
+    php callcenter_subscriber.php
+*/
+
+if (php_sapi_name() != 'cli') {
+    exit;
+}
+
+require_once('./settings.inc');
+require_once('./lib/EventSocketLayer.php');
+require_once('./lib/metrics_lib.inc');
+require_once('./lib/freeswitch_lib.inc');
+
+if (!ENABLE_MEMCACHE) {
+    echo "The callcenter subscriber shares its state through memcache, set ENABLE_MEMCACHE in settings.inc".PHP_EOL;
+    exit(1);
+}
+
+if (!extension_loaded('ESL')) {
+	if (!dl('ESL.so')){
+		echo "You Must have the FreeSwitch ESL PHP Module Loaded".PHP_EOL;
+		exit(1);
+	}
+}
+
+require_once('./lib/memcache_lib.inc');
+require_once('./lib/user_lib.inc');
+require_once('./lib/callcenter_lib.inc');
+require_once('./lib/callcenter_state_lib.inc');
+
+callcenterSubscribe();
@@ -1,6 +1,10 @@
 <?php
 chdir(__DIR__);
 include('./settings.inc');
+include('lib/metrics_lib.inc');
+if (ENABLE_MEMCACHE) {
+    include('lib/memcache_lib.inc');
+}
 include('lib/user_lib.inc');
 
 $data = array(
@@ -5,7 +5,10 @@ require_once('./vendor/autoload.php');
 
 // Put all Call Center functions here
 require_once('./lib/EventSocketLayer.php');
+require_once('./lib/metrics_lib.inc');
 require_once('./lib/freeswitch_lib.inc');
+require_once('./lib/SkydasJsonView.php');
+require_once('./lib/SkydasMetricsMiddleware.php');
 
 if(ENABLE_MEMCACHE){
     require_once('./lib/memcache_lib.inc');
@@ -24,8 +27,9 @@ if (!extension_loaded('ESL')) {
 }
 
 $app = new \Slim\Slim();
-$app->view(new \JsonApiView());
+$app->view(new \SkydasJsonView());
 $app->add(new \JsonApiMiddleware());
+$app->add(new \SkydasMetricsMiddleware());
 
 function skydas_autoload($loader_name) {
   global $app;
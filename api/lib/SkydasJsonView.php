@@ -0,0 +1,38 @@
+<?php
+
+/**
+JsonApiView that tags successful GET responses with an ETag so clients
+revalidating an unchanged payload get an empty 304 instead of the body.
+
+Routes serving cached data can call $app->etag() with the cache hash
+before rendering, which answers the 304 without building the response.
+*/
+class SkydasJsonView extends JsonApiView {
+
+    public function render($status=200) {
+        $app = \Slim\Slim::getInstance();
+
+        $status = intval($status);
+
+        if (!$this->has('error')) {
+            $this->set('error', false);
+        }
+        $this->set('status', $status);
+
+        $body = json_encode($this->all());
+
+        if ($status == 200 && $app->request()->isGet()) {
+            $app->response()->header('Cache-Control', 'no-cache');
+            if (is_null($app->response()->header('ETag'))) {
+                $app->etag(md5($body));
+            }
+        }
+
+        $app->response()->status($status);
+        $app->response()->header('Content-Type', 'application/json');
+        $app->response()->body($body);
+
+        $app->stop();
+    }
+
+}
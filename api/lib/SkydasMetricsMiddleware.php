@@ -0,0 +1,24 @@
+<?php
+
+/**
+Records latency and response size of every request by route pattern, so
+/:queue/agents is one series however many queues there are.
+*/
+class SkydasMetricsMiddleware extends \Slim\Middleware {
+
+    public function call() {
+        $start = microtime(true);
+        $this->next->call();
+
+        $route = $this->app->router()->getCurrentRoute();
+        $pattern = is_null($route) ? 'unmatched' : $route->getPattern();
+        $response = $this->app->response();
+        skymetric_observe('skydas_http_request_duration_seconds', array(
+            'route' => $pattern,
+            'method' => $this->app->request()->getMethod(),
+            'status' => $response->status(),
+        ), microtime(true) - $start);
+        skymetric_observe('skydas_http_response_bytes', array('route' => $pattern), strlen($response->body()));
+    }
+
+}
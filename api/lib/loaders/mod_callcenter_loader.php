@@ -5,4 +5,5 @@ Mod_Callcenter Loader File
 */
 
 require_once('./lib/callcenter_lib.inc');
+require_once('./lib/callcenter_state_lib.inc');
 require_once('./routes/mod_callcenter_routes.inc');
\ No newline at end of file
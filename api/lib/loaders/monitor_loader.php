@@ -6,4 +6,5 @@ Monitor Loader
 File should Contain Routes and any Libs needed
 */
 
+require_once('./lib/stats_lib.inc');
 require_once('./routes/monitor_status_routes.inc');
\ No newline at end of file
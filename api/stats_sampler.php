@@ -0,0 +1,41 @@
+<?php
+chdir(__DIR__);
+
+/**
+Long running stats sampler feeding /monitor/history
+
+Run from the command line (supervisord, systemd, etc) next to the API:
+    php stats_sampler.php
+*/
+
+if (php_sapi_name() != 'cli') {
+    exit;
+}
+
+require_once('./settings.inc');
+require_once('./lib/EventSocketLayer.php');
+require_once('./lib/metrics_lib.inc');
+require_once('./lib/freeswitch_lib.inc');
+
+if (ENABLE_MEMCACHE) {
+    require_once('./lib/memcache_lib.inc');
+}
+
+if (!extension_loaded('ESL')) {
+	if (!dl('ESL.so')){
+		echo "You Must have the FreeSwitch ESL PHP Module Loaded".PHP_EOL;
+		exit(1);
+	}
+}
+
+if (!is_dir(STATS_DIR) && !mkdir(STATS_DIR, 0755, true)) {
+    echo "Unable to create STATS_DIR ".STATS_DIR.PHP_EOL;
+    exit(1);
+}
+
+require_once('./lib/user_lib.inc');
+require_once('./lib/callcenter_lib.inc');
+require_once('./lib/callcenter_state_lib.inc');
+require_once('./lib/stats_lib.inc');
+
+statsSampleLoop();
@@ -0,0 +1,164 @@
+#!/usr/bin/env node
+
+/*
+  Throughput and latency benchmark for the API. Drives every route at each
+  concurrency level for a fixed time with keep-alive connections and
+  reports req/s and latency percentiles. Point the API at
+  fake-esl-server.js to run it without a FreeSWITCH box.
+
+  node bench/bench.js --url http://localhost/api --concurrency 1,10,50 --duration 10
+*/
+
+var http = require('http'),
+    https = require('https'),
+    url = require('url');
+
+var DEFAULTS = {
+  url: 'http://localhost/api',
+  routes: '/queues/all,/queue1/agents,/channels,/user/1000',
+  concurrency: '1,10,50',
+  duration: 10,     // seconds per route and concurrency level
+  json: 'false'     // print results as JSON for comparing runs
+};
+
+function parseArgs(argv) {
+  var options = {};
+  Object.keys(DEFAULTS).forEach(function(key) {
+    options[key] = DEFAULTS[key];
+  });
+  for (var i = 2; i < argv.length; i += 2) {
+    var key = argv[i].replace(/^--/, '');
+    if (!(key in DEFAULTS)) {
+      console.error('Unknown option --' + key);
+      process.exit(1);
+    }
+    options[key] = (typeof DEFAULTS[key] === 'number') ? Number(argv[i + 1]) : argv[i + 1];
+  }
+  return options;
+}
+
+function percentile(sorted, p) {
+  if (!sorted.length) {
+    return 0;
+  }
+  return sorted[Math.min(sorted.length - 1, Math.ceil(p / 100 * sorted.length) - 1)];
+}
+
+function run(target, concurrency, duration, done) {
+  var parsed = url.parse(target),
+      client = (parsed.protocol === 'https:') ? https : http,
+      agent = new client.Agent({keepAlive: true, maxSockets: concurrency}),
+      deadline = Date.now() + duration * 1000,
+      latencies = [],
+      errors = 0,
+      bytes = 0,
+      running = concurrency,
+      started = Date.now();
+
+  function finish() {
+    if (--running > 0) {
+      return;
+    }
+    agent.destroy();
+    var elapsed = (Date.now() - started) / 1000;
+    latencies.sort(function(a, b) { return a - b; });
+    done({
+      requests: latencies.length,
+      errors: errors,
+      rps: latencies.length / elapsed,
+      p50: percentile(latencies, 50),
+      p95: percentile(latencies, 95),
+      p99: percentile(latencies, 99),
+      bytes: latencies.length ? Math.round(bytes / latencies.length) : 0
+    });
+  }
+
+  function worker() {
+    if (Date.now() >= deadline) {
+      return finish();
+    }
+    var start = process.hrtime();
+    var req = client.get({
+      hostname: parsed.hostname, port: parsed.port, path: parsed.path, agent: agent
+    }, function(res) {
+      var size = 0;
+      res.on('data', function(chunk) {
+        size += chunk.length;
+      });
+      res.on('end', function() {
+        var diff = process.hrtime(start);
+        if (res.statusCode >= 400) {
+          errors++;
+        }
+        latencies.push(diff[0] * 1000 + diff[1] / 1e6);
+        bytes += size;
+        worker();
+      });
+    });
+    req.on('error', function() {
+      errors++;
+      setTimeout(worker, 10);
+    });
+  }
+
+  for (var i = 0; i < concurrency; i++) {
+    worker();
+  }
+}
+
+function main(argv) {
+  var options = parseArgs(argv),
+      routes = options.routes.split(','),
+      levels = options.concurrency.split(',').map(Number),
+      jobs = [],
+      results = [];
+
+  routes.forEach(function(route) {
+    levels.forEach(function(concurrency) {
+      jobs.push({route: route, concurrency: concurrency});
+    });
+  });
+
+  if (options.json !== 'true') {
+    console.log('route                     conc     req/s    p50 ms    p95 ms    p99 ms   errors   avg bytes');
+  }
+
+  (function next() {
+    var job = jobs.shift();
+    if (!job) {
+      if (options.json === 'true') {
+        console.log(JSON.stringify(results, null, 2));
+      }
+      return;
+    }
+    run(options.url + job.route, job.concurrency, options.duration, function(result) {
+      result.route = job.route;
+      result.concurrency = job.concurrency;
+      results.push(result);
+      if (options.json !== 'true') {
+        console.log(pad(job.route, 24) + lpad(job.concurrency, 6) + lpad(result.rps.toFixed(1), 10) +
+          lpad(result.p50.toFixed(1), 10) + lpad(result.p95.toFixed(1), 10) + lpad(result.p99.toFixed(1), 10) +
+          lpad(result.errors, 9) + lpad(result.bytes, 12));
+      }
+      next();
+    });
+  }());
+}
+
+function pad(value, width) {
+  value = String(value);
+  while (value.length < width) {
+    value += ' ';
+  }
+  return value;
+}
+
+function lpad(value, width) {
+  value = String(value);
+  while (value.length < width) {
+    value = ' ' + value;
+  }
+  return value;
+}
+
+main(process.argv);
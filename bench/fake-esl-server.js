@@ -0,0 +1,473 @@
+#!/usr/bin/env node
+
+/*
+  Fake FreeSWITCH inbound event socket for load testing the API without a
+  real switch. Speaks enough of the protocol for the PHP ESL module: auth,
+  api, bgapi with BACKGROUND_JOB events, event/noevents subscriptions and
+  exit. Answers callcenter_config, list_users and show with generated data
+  shaped like the real output.
+
+  node bench/fake-esl-server.js --queues 12 --agents 25 --members 5 --latency 2
+*/
+
+var net = require('net');
+
+var DEFAULTS = {
+  port: 8021,
+  password: 'ClueCon',
+  domain: 'default',
+  queues: 3,        // queue1..queueN
+  agents: 10,       // per queue
+  members: 3,       // waiting or answered callers per queue
+  users: 300,       // directory entries, extensions from 1000
+  channels: 200,
+  latency: 0,       // ms added to every api/bgapi reply
+  events: 0         // callcenter::info events per second
+};
+
+function parseArgs(argv) {
+  var options = {};
+  Object.keys(DEFAULTS).forEach(function(key) {
+    options[key] = DEFAULTS[key];
+  });
+  for (var i = 2; i < argv.length; i += 2) {
+    var key = argv[i].replace(/^--/, '');
+    if (!(key in DEFAULTS)) {
+      console.error('Unknown option --' + key);
+      process.exit(1);
+    }
+    options[key] = (typeof DEFAULTS[key] === 'number') ? Number(argv[i + 1]) : argv[i + 1];
+  }
+  return options;
+}
+
+function uuid() {
+  return 'xxxxxxxx-xxxx-4xxx-yxxx-xxxxxxxxxxxx'.replace(/[xy]/g, function(c) {
+    var r = Math.random() * 16 | 0;
+    return (c === 'x' ? r : (r & 0x3 | 0x8)).toString(16);
+  });
+}
+
+function now() {
+  return Math.floor(Date.now() / 1000);
+}
+
+/*
+  Switch state
+*/
+
+function Switch(options) {
+  this.options = options;
+  this.queues = [];
+  this.agents = {};
+  this.users = [];
+  this.channels = [];
+
+  for (var u = 0; u < options.users; u++) {
+    this.users.push({id: String(1000 + u), name: 'User ' + (1000 + u)});
+  }
+
+  for (var q = 1; q <= options.queues; q++) {
+    var queue = {name: 'queue' + q + '@' + options.domain, agents: [], members: {}};
+    for (var a = 0; a < options.agents; a++) {
+      // Spread agents over the directory, some sit in several queues
+      var ext = String(1000 + ((q - 1) * options.agents + a) % Math.max(options.users, 1));
+      var name = ext + '@' + options.domain;
+      if (!this.agents[name]) {
+        this.agents[name] = {
+          name: name, status: 'Available', state: 'Waiting',
+          no_answer_count: 0, calls_answered: Math.floor(Math.random() * 40)
+        };
+      }
+      queue.agents.push(name);
+    }
+    for (var m = 0; m < options.members; m++) {
+      this.addMember(queue);
+    }
+    this.queues.push(queue);
+  }
+
+  for (var c = 0; c < options.channels; c++) {
+    this.channels.push(this.makeChannel());
+  }
+}
+
+Switch.prototype.addMember = function(queue) {
+  var id = uuid(),
+      answered = Math.random() < 0.5 && queue.agents.length,
+      number = '+1916' + String(Math.floor(Math.random() * 9000000) + 1000000);
+  queue.members[id] = {
+    queue: queue.name, system: 'single_box', uuid: id, session_uuid: uuid(),
+    cid_number: number, cid_name: number,
+    system_epoch: now(), joined_epoch: now() - Math.floor(Math.random() * 300),
+    rejoined_epoch: 0, bridge_epoch: answered ? now() : 0, abandoned_epoch: 0,
+    base_score: 0, skill_score: 0,
+    serving_agent: answered ? queue.agents[0] : '', serving_system: answered ? 'single_box' : '',
+    state: answered ? 'Answered' : 'Waiting'
+  };
+  return queue.members[id];
+};
+
+Switch.prototype.makeChannel = function() {
+  var ext = this.users.length ? this.users[Math.floor(Math.random() * this.users.length)].id : '1000';
+  return {
+    uuid: uuid(), direction: 'inbound', created: new Date().toISOString().replace('T', ' ').substr(0, 19),
+    created_epoch: now(), name: 'sofia/internal/' + ext + '@fs.example.com', state: 'CS_EXECUTE',
+    cid_name: 'User ' + ext, cid_num: ext, ip_addr: '10.0.0.' + (Math.floor(Math.random() * 250) + 1),
+    dest: '8' + ext, application: 'bridge', application_data: 'user/' + ext, dialplan: 'XML',
+    context: 'default', read_codec: 'PCMU', read_rate: 8000, read_bit_rate: 64000,
+    write_codec: 'PCMU', write_rate: 8000, write_bit_rate: 64000, secure: '',
+    hostname: 'fs.example.com', presence_id: ext + '@fs.example.com', presence_data: '',
+    accountcode: ext, callstate: 'ACTIVE', callee_name: 'Outbound Call', callee_num: '8' + ext,
+    callee_direction: 'SEND', call_uuid: '', sent_callee_name: '', sent_callee_num: '',
+    initial_cid_name: 'User ' + ext, initial_cid_num: ext, initial_ip_addr: '10.0.0.1',
+    initial_dest: '8' + ext, initial_dialplan: 'XML', initial_context: 'default'
+  };
+};
+
+Switch.prototype.findQueue = function(name) {
+  for (var i = 0; i < this.queues.length; i++) {
+    if (this.queues[i].name === name) {
+      return this.queues[i];
+    }
+  }
+  return null;
+};
+
+function table(columns, rows, delim) {
+  var lines = [columns.join(delim)];
+  rows.forEach(function(row) {
+    lines.push(columns.map(function(col) {
+      return row[col] === undefined ? '' : String(row[col]);
+    }).join(delim));
+  });
+  return lines.join('\n') + '\n';
+}
+
+var AGENT_COLUMNS = ['name', 'system', 'uuid', 'type', 'contact', 'status', 'state', 'max_no_answer',
+  'wrap_up_time', 'reject_delay_time', 'busy_delay_time', 'no_answer_delay_time', 'last_bridge_start',
+  'last_bridge_end', 'last_offered_call', 'last_status_change', 'no_answer_count', 'calls_answered',
+  'talk_time', 'ready_time'];
+var TIER_COLUMNS = ['queue', 'agent', 'state', 'level', 'position'];
+var MEMBER_COLUMNS = ['queue', 'system', 'uuid', 'session_uuid', 'cid_number', 'cid_name', 'system_epoch',
+  'joined_epoch', 'rejoined_epoch', 'bridge_epoch', 'abandoned_epoch', 'base_score', 'skill_score',
+  'serving_agent', 'serving_system', 'state'];
+var USER_COLUMNS = ['userid', 'context', 'domain', 'group', 'contact', 'callgroup',
+  'effective_caller_id_name', 'effective_caller_id_number'];
+var CHANNEL_COLUMNS = ['uuid', 'direction', 'created', 'created_epoch', 'name', 'state', 'cid_name', 'cid_num',
+  'ip_addr', 'dest', 'application', 'application_data', 'dialplan', 'context', 'read_codec', 'read_rate',
+  'read_bit_rate', 'write_codec', 'write_rate', 'write_bit_rate', 'secure', 'hostname', 'presence_id',
+  'presence_data', 'accountcode', 'callstate', 'callee_name', 'callee_num', 'callee_direction', 'call_uuid',
+  'sent_callee_name', 'sent_callee_num', 'initial_cid_name', 'initial_cid_num', 'initial_ip_addr',
+  'initial_dest', 'initial_dialplan', 'initial_context'];
+
+Switch.prototype.agentRow = function(name) {
+  var agent = this.agents[name];
+  return {
+    name: name, system: 'single_box', uuid: '', type: 'callback',
+    contact: '[call_timeout=10]user/' + name, status: agent.status, state: agent.state,
+    max_no_answer: 3, wrap_up_time: 10, reject_delay_time: 10, busy_delay_time: 60,
+    no_answer_delay_time: 10, last_bridge_start: 0, last_bridge_end: 0, last_offered_call: 0,
+    last_status_change: now(), no_answer_count: agent.no_answer_count,
+    calls_answered: agent.calls_answered, talk_time: 0, ready_time: 0
+  };
+};
+
+Switch.prototype.tierRows = function(queue) {
+  return queue.agents.map(function(agent, i) {
+    return {queue: queue.name, agent: agent, state: 'Ready', level: 1, position: i + 1};
+  });
+};
+
+Switch.prototype.callcenter = function(args) {
+  var self = this, queue;
+  if (args[0] === 'queue' && args[1] === 'list') {
+    queue = this.findQueue(args[3]);
+    if (!queue) {
+      return '-ERR Queue not found!\n';
+    }
+    if (args[2] === 'agents') {
+      return table(AGENT_COLUMNS, queue.agents.map(function(name) { return self.agentRow(name); }), '|') + '+OK\n';
+    } else if (args[2] === 'tiers') {
+      return table(TIER_COLUMNS, this.tierRows(queue), '|') + '+OK\n';
+    } else if (args[2] === 'members') {
+      var members = Object.keys(queue.members).map(function(id) { return queue.members[id]; });
+      return table(MEMBER_COLUMNS, members, '|') + '+OK\n';
+    }
+  } else if (args[0] === 'tier' && args[1] === 'list') {
+    var tiers = [];
+    this.queues.forEach(function(queue) {
+      tiers = tiers.concat(self.tierRows(queue));
+    });
+    return table(TIER_COLUMNS, tiers, '|') + '+OK\n';
+  } else if (args[0] === 'agent' && args[1] === 'get' && this.agents[args[3]]) {
+    return this.agents[args[3]][args[2]] + '\n';
+  } else if (args[0] === 'agent' && args[1] === 'set' && this.agents[args[3]]) {
+    this.agents[args[3]][args[2]] = args.slice(4).join(' ').replace(/'/g, '');
+    return '+OK\n';
+  }
+  return '-ERR Unknown Command\n';
+};
+
+Switch.prototype.show = function(args) {
+  var delim = ',', like = null, what = args[0];
+  var as = args.indexOf('as');
+  if (as !== -1) {
+    if (args[as + 1] === 'delim' && args[as + 2]) {
+      delim = args[as + 2];
+    }
+    args = args.slice(0, as);
+  }
+  if (args[1] === 'like') {
+    like = args[2];
+  }
+  if (what !== 'channels' && what !== 'calls') {
+    return '-ERR Unsupported show\n';
+  }
+  var rows = this.channels.filter(function(channel) {
+    return !like || ['uuid', 'name', 'cid_name', 'cid_num', 'presence_id'].some(function(col) {
+      return channel[col].indexOf(like) !== -1;
+    });
+  });
+  if (args[1] === 'count') {
+    var count = (what === 'calls') ? Math.floor(rows.length / 2) : rows.length;
+    return '\n' + count + ' total.\n';
+  }
+  if (what === 'calls') {
+    rows = rows.slice(0, Math.floor(rows.length / 2));
+  }
+  return table(CHANNEL_COLUMNS, rows, delim) + '\n' + rows.length + ' total.\n';
+};
+
+Switch.prototype.api = function(command) {
+  var args = command.trim().split(/\s+/),
+      verb = args.shift();
+  switch (verb) {
+    case 'callcenter_config':
+      return this.callcenter(args);
+    case 'list_users':
+      return table(USER_COLUMNS, this.users.map(function(user) {
+        return {
+          userid: user.id, context: 'default', domain: 'fs.example.com', group: 'default',
+          contact: 'error/user_not_registered', callgroup: 'techsupport',
+          effective_caller_id_name: user.name, effective_caller_id_number: user.id
+        };
+      }), '|') + '\n+OK\n';
+    case 'show':
+      return this.show(args);
+    case 'status':
+      return 'UP 0 years, 0 days, 1 hour, 2 minutes, 3 seconds, 0 milliseconds, 0 microseconds\n' +
+        'FreeSWITCH (Version 1.2.stable) is ready\n' + this.channels.length + ' session(s) since startup\n';
+    case 'uptime':
+      return '3723\n';
+    case 'reloadxml':
+      return '+OK [Success]\n';
+    default:
+      return '-ERR ' + verb + ' Command not found!\n';
+  }
+};
+
+/*
+  Random callcenter::info traffic for event subscribers
+*/
+
+Switch.prototype.randomEvent = function() {
+  var queue = this.queues[Math.floor(Math.random() * this.queues.length)],
+      headers = {'Event-Name': 'CUSTOM', 'Event-Subclass': 'callcenter::info', 'CC-Queue': queue.name},
+      ids = Object.keys(queue.members),
+      roll = Math.random();
+
+  if (roll < 0.3 && queue.agents.length) {
+    var name = queue.agents[Math.floor(Math.random() * queue.agents.length)],
+        statuses = ['Available', 'On Break', 'Logged Out'];
+    this.agents[name].status = statuses[Math.floor(Math.random() * statuses.length)];
+    headers['CC-Action'] = 'agent-status-change';
+    headers['CC-Agent'] = name;
+    headers['CC-Agent-Status'] = this.agents[name].status;
+  } else if (roll < 0.65 || !ids.length) {
+    var member = this.addMember(queue);
+    member.bridge_epoch = 0;
+    member.serving_agent = '';
+    member.state = 'Waiting';
+    headers['CC-Action'] = 'member-queue-start';
+    headers['CC-Member-UUID'] = member.uuid;
+    headers['CC-Member-Session-UUID'] = member.session_uuid;
+    headers['CC-Member-CID-Name'] = member.cid_name;
+    headers['CC-Member-CID-Number'] = member.cid_number;
+  } else {
+    var id = ids[Math.floor(Math.random() * ids.length)];
+    delete queue.members[id];
+    headers['CC-Action'] = 'member-queue-end';
+    headers['CC-Member-UUID'] = id;
+    headers['CC-Cause'] = 'Terminated';
+  }
+  return headers;
+};
+
+/*
+  Protocol
+*/
+
+function encodeEvent(headers, body) {
+  var text = '';
+  headers['Event-Date-Timestamp'] = String(Date.now() * 1000);
+  if (body !== undefined) {
+    headers['Content-Length'] = String(Buffer.byteLength(body));
+  }
+  Object.keys(headers).forEach(function(key) {
+    text += key + ': ' + encodeURIComponent(headers[key]) + '\n';
+  });
+  text += '\n' + (body === undefined ? '' : body);
+  return 'Content-Length: ' + Buffer.byteLength(text) + '\nContent-Type: text/event-plain\n\n' + text;
+}
+
+function reply(text, extra) {
+  return 'Content-Type: command/reply\nReply-Text: ' + text + '\n' + (extra || '') + '\n';
+}
+
+function Session(socket, fs, server) {
+  this.socket = socket;
+  this.fs = fs;
+  this.server = server;
+  this.authed = false;
+  this.events = [];
+  this.buffer = '';
+  socket.setNoDelay(true);
+  socket.on('data', this.onData.bind(this));
+  socket.on('error', function() {});
+  socket.on('close', function() {
+    var i = server.sessions.indexOf(this);
+    if (i !== -1) {
+      server.sessions.splice(i, 1);
+    }
+  }.bind(this));
+  socket.write('Content-Type: auth/request\n\n');
+}
+
+Session.prototype.subscribed = function(name, subclass) {
+  var events = this.events;
+  return events.indexOf('ALL') !== -1 || events.indexOf(name) !== -1 ||
+    (subclass && events.indexOf(subclass) !== -1 && events.indexOf('CUSTOM') !== -1);
+};
+
+Session.prototype.send = function(data) {
+  if (!this.socket.destroyed) {
+    this.socket.write(data);
+  }
+};
+
+Session.prototype.later = function(fn) {
+  var latency = this.fs.options.latency;
+  if (latency > 0) {
+    setTimeout(fn, latency);
+  } else {
+    setImmediate(fn);
+  }
+};
+
+Session.prototype.onData = function(chunk) {
+  this.buffer += chunk.toString();
+  var end;
+  while ((end = this.buffer.indexOf('\n\n')) !== -1) {
+    var message = this.buffer.substr(0, end);
+    this.buffer = this.buffer.substr(end + 2);
+    this.handle(message);
+  }
+};
+
+Session.prototype.handle = function(message) {
+  var self = this,
+      lines = message.split('\n'),
+      command = lines.shift().trim(),
+      headers = {};
+  lines.forEach(function(line) {
+    var i = line.indexOf(':');
+    if (i !== -1) {
+      headers[line.substr(0, i).trim()] = line.substr(i + 1).trim();
+    }
+  });
+
+  if (!this.authed) {
+    if (command === 'auth ' + this.fs.options.password) {
+      this.authed = true;
+      this.send(reply('+OK accepted'));
+    } else {
+      this.send(reply('-ERR invalid'));
+      this.send('Content-Type: text/disconnect-notice\nContent-Length: 0\n\n');
+      this.socket.end();
+    }
+    return;
+  }
+
+  var space = command.indexOf(' '),
+      verb = (space === -1) ? command : command.substr(0, space),
+      rest = (space === -1) ? '' : command.substr(space + 1);
+
+  switch (verb) {
+    case 'api':
+      this.later(function() {
+        var body = self.fs.api(rest);
+        self.send('Content-Type: api/response\nContent-Length: ' + Buffer.byteLength(body) + '\n\n' + body);
+      });
+      break;
+    case 'bgapi':
+      var job = headers['Job-UUID'] || uuid();
+      this.send(reply('+OK Job-UUID: ' + job, 'Job-UUID: ' + job + '\n'));
+      this.later(function() {
+        if (self.subscribed('BACKGROUND_JOB')) {
+          var args = rest.split(' ');
+          self.send(encodeEvent({
+            'Event-Name': 'BACKGROUND_JOB', 'Job-UUID': job,
+            'Job-Command': args[0], 'Job-Command-Arg': args.slice(1).join(' ')
+          }, self.fs.api(rest)));
+        }
+      });
+      break;
+    case 'event':
+      // event plain CUSTOM callcenter::info BACKGROUND_JOB ...
+      this.events = this.events.concat(rest.split(/\s+/).slice(1));
+      this.send(reply('+OK event listener enabled plain'));
+      break;
+    case 'noevents':
+      this.events = [];
+      this.send(reply('+OK no longer listening for events'));
+      break;
+    case 'filter':
+      this.send(reply('+OK filter added. [' + rest + ']'));
+      break;
+    case 'exit':
+      this.send(reply('+OK bye'));
+      this.send('Content-Type: text/disconnect-notice\nContent-Length: 0\n\n');
+      this.socket.end();
+      break;
+    default:
+      this.send(reply('-ERR command not found'));
+  }
+};
+
+function main(argv) {
+  var options = parseArgs(argv),
+      fs = new Switch(options),
+      server = net.createServer(function(socket) {
+        server.sessions.push(new Session(socket, fs, server));
+      });
+  server.sessions = [];
+
+  if (options.events > 0) {
+    setInterval(function() {
+      var headers = fs.randomEvent();
+      server.sessions.forEach(function(session) {
+        if (session.authed && session.subscribed('CUSTOM', 'callcenter::info')) {
+          session.send(encodeEvent(JSON.parse(JSON.stringify(headers))));
+        }
+      });
+    }, 1000 / options.events);
+  }
+
+  server.listen(options.port, function() {
+    console.log('Fake ESL server on port %d: %d queues, %d agents/queue, %d users, %d channels',
+      options.port, options.queues, options.agents, options.users, options.channels);
+  });
+}
+
+main(process.argv);
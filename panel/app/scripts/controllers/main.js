@@ -1,7 +1,7 @@
 'use strict';
 
 angular.module('callstatsApp')
-    .controller('MainCtrl', function ($scope, $http, config) {
+    .controller('MainCtrl', function ($scope, $http, $timeout, config) {
 	   $scope.url = config.PANEL.API_URL;
 	  
 	  $scope.loadQueues = function () {
@@ -10,7 +10,9 @@ angular.module('callstatsApp')
 	  			method: 'GET',
 	  			url: ($scope.url + '/queues/fetch'),
 	  		}).success(function(data,status){
-	  			$scope.queues = data.msg; 
+	  			if (!$scope.live) {
+	  				$scope.queues = data.msg;
+	  			}
 	  		});
 	  	}());
 	  }
@@ -22,13 +24,154 @@ angular.module('callstatsApp')
 			                 method: 'GET',
 			                 url: ($scope.url + '/queues/all'),     
 			         }).success(function(data, status) {
-							                 $scope.queues = data.msg;
+							                 if (!$scope.live) {
+							                     $scope.queues = data.msg;
+							                 }
 			         });
 			     }());
     	$scope.timeout = setTimeout(function(){
         	$scope.loadCalls();
     	}, 30000);		
       } 
+
+      // Live updates from /queues/stream: one snapshot, then per agent and
+      // per caller deltas applied in place so ng-repeat only redraws the
+      // rows that changed. The browser reconnects on its own and resumes
+      // from the last event id. When the API has no stream to offer the
+      // panel polls and keeps retrying the stream with a growing delay.
+      $scope.live = false;
+      $scope.skew = 0;
+
+      var byJoined = function(a, b) {
+        return a.joined_epoch - b.joined_epoch;
+      };
+
+      var holdTime = function(call) {
+        var held = Math.floor(Date.now() / 1000 - $scope.skew) - call.joined_epoch;
+        return Math.floor(held / 60) + ':' + (held % 60);
+      };
+
+      $scope.applySnapshot = function(data) {
+        var queues = {};
+        $scope.skew = Date.now() / 1000 - data.time;
+        angular.forEach(data.queues, function(queue, name) {
+          var callers = [];
+          angular.forEach(queue.callers, function(call) {
+            callers.push(call);
+          });
+          callers.sort(byJoined);
+          queues[name] = {agents: queue.agents, callers: callers};
+        });
+        $scope.queues = queues;
+        $scope.live = true;
+        $scope.updateHoldTimes();
+      };
+
+      $scope.applyDelta = function(delta) {
+        var queue, callers, i;
+        if (!$scope.live) {
+          return;
+        }
+        queue = $scope.queues[delta.queue];
+        if (!queue) {
+          queue = $scope.queues[delta.queue] = {agents: {}, callers: []};
+        }
+        if (delta.type === 'agent') {
+          if (delta.data === null) {
+            delete queue.agents[delta.key];
+          } else {
+            queue.agents[delta.key] = delta.data;
+          }
+          return;
+        }
+        callers = queue.callers;
+        for (i = 0; i < callers.length && callers[i].uuid !== delta.key; i++) {}
+        if (delta.data === null) {
+          if (i < callers.length) {
+            callers.splice(i, 1);
+          }
+          return;
+        }
+        if (delta.data.bridge_epoch === '0') {
+          delta.data.hold_time = holdTime(delta.data);
+        }
+        if (i < callers.length) {
+          callers[i] = delta.data;
+        } else {
+          callers.push(delta.data);
+          callers.sort(byJoined);
+        }
+      };
+
+      $scope.updateHoldTimes = function() {
+        angular.forEach($scope.queues, function(queue) {
+          angular.forEach(queue.callers, function(call) {
+            if (call.bridge_epoch === '0') {
+              call.hold_time = holdTime(call);
+            }
+          });
+        });
+      };
+
+      $scope.streamCalls = function() {
+        var source, pending = null, polling = false, backoff = 5000;
+
+        if (!window.EventSource) {
+          $scope.loadCalls();
+          return;
+        }
+
+        var tick = function() {
+          if ($scope.live) {
+            $scope.updateHoldTimes();
+          }
+          $timeout(tick, 1000);
+        };
+
+        var open = function() {
+          source = new EventSource($scope.url + '/queues/stream');
+
+          source.addEventListener('snapshot', function(e) {
+            var data = JSON.parse(e.data);
+            $scope.$apply(function() {
+              if (polling) {
+                clearTimeout($scope.timeout);
+                polling = false;
+              }
+              backoff = 5000;
+              $scope.applySnapshot(data);
+            });
+          });
+
+          source.addEventListener('delta', function(e) {
+            $scope.applyDelta(JSON.parse(e.data));
+            // Deltas arrive in bursts, digest once per burst
+            if (!pending) {
+              pending = $timeout(function() {
+                pending = null;
+              }, 100);
+            }
+          });
+
+          source.onerror = function() {
+            if (source.readyState !== EventSource.CLOSED) {
+              return;
+            }
+            $scope.$apply(function() {
+              $scope.live = false;
+              if (!polling) {
+                polling = true;
+                $scope.loadCalls();
+              }
+              $timeout(open, backoff);
+              backoff = Math.min(backoff * 2, 300000);
+            });
+          };
+        };
+
+        open();
+        tick();
+      }
     $scope.loadQueues();
-	$scope.loadCalls();
+	$scope.streamCalls();
   });
@@ -20,3 +20,163 @@ describe('Controller: MainCtrl', function () {
     expect(scope.awesomeThings.length).toBe(3);
   });
 });
+
+describe('Controller: MainCtrl queue stream', function () {
+
+  beforeEach(module('callstatsApp'));
+
+  var scope,
+    $timeout,
+    $httpBackend,
+    sources,
+    now = 1400000000;
+
+  var FakeEventSource = function (url) {
+    this.url = url;
+    this.readyState = 0;
+    this.listeners = {};
+    sources.push(this);
+  };
+  FakeEventSource.CLOSED = 2;
+  FakeEventSource.prototype.addEventListener = function (type, fn) {
+    this.listeners[type] = fn;
+  };
+  FakeEventSource.prototype.emit = function (type, data) {
+    this.listeners[type]({data: JSON.stringify(data)});
+  };
+
+  var caller = function (uuid, joined, bridged) {
+    return {uuid: uuid, cid_number: uuid, joined_epoch: String(joined), bridge_epoch: bridged ? String(now) : '0'};
+  };
+
+  var snapshot = function () {
+    return {
+      seq: 10,
+      time: now,
+      queues: {
+        support: {
+          agents: {'1000@default': {name: '1000@default', status: 'Available'}},
+          callers: {b: caller('b', now - 30), a: caller('a', now - 75)}
+        }
+      }
+    };
+  };
+
+  beforeEach(inject(function ($controller, $rootScope, _$timeout_, _$httpBackend_) {
+    sources = [];
+    window.EventSource = FakeEventSource;
+    spyOn(Date, 'now').andReturn(now * 1000);
+    $timeout = _$timeout_;
+    $httpBackend = _$httpBackend_;
+    $httpBackend.whenGET('/api/queues/fetch').respond({msg: {support: {agents: {}, callers: {}}}});
+    $httpBackend.whenGET('/api/queues/all').respond({msg: {polled: {agents: [], callers: []}}});
+    scope = $rootScope.$new();
+    $controller('MainCtrl', {
+      $scope: scope,
+      config: {PANEL: {API_URL: '/api'}}
+    });
+  }));
+
+  it('should open the stream', function () {
+    expect(sources.length).toBe(1);
+    expect(sources[0].url).toBe('/api/queues/stream');
+  });
+
+  it('should build the queues from a snapshot', function () {
+    sources[0].emit('snapshot', snapshot());
+    var queue = scope.queues.support;
+    expect(scope.live).toBe(true);
+    expect(queue.agents['1000@default'].status).toBe('Available');
+    expect(queue.callers.length).toBe(2);
+    expect(queue.callers[0].uuid).toBe('a');
+    expect(queue.callers[0].hold_time).toBe('1:15');
+  });
+
+  it('should ignore deltas before the snapshot', function () {
+    sources[0].emit('delta', {seq: 11, queue: 'support', type: 'agent', key: '1001@default', data: {name: '1001@default'}});
+    expect(scope.live).toBe(false);
+    expect(scope.queues).toBeUndefined();
+  });
+
+  it('should apply agent deltas in place', function () {
+    sources[0].emit('snapshot', snapshot());
+    var queues = scope.queues,
+      agents = scope.queues.support.agents;
+    sources[0].emit('delta', {seq: 11, queue: 'support', type: 'agent', key: '1000@default', data: {name: '1000@default', status: 'On Break'}});
+    sources[0].emit('delta', {seq: 12, queue: 'support', type: 'agent', key: '1001@default', data: {name: '1001@default', status: 'Available'}});
+    expect(scope.queues).toBe(queues);
+    expect(scope.queues.support.agents).toBe(agents);
+    expect(agents['1000@default'].status).toBe('On Break');
+    expect(agents['1001@default'].status).toBe('Available');
+    sources[0].emit('delta', {seq: 13, queue: 'support', type: 'agent', key: '1000@default', data: null});
+    expect(agents['1000@default']).toBeUndefined();
+  });
+
+  it('should add, update and remove callers', function () {
+    sources[0].emit('snapshot', snapshot());
+    var callers = scope.queues.support.callers,
+      untouched = callers[1];
+    sources[0].emit('delta', {seq: 11, queue: 'support', type: 'caller', key: 'c', data: caller('c', now - 120)});
+    expect(callers.length).toBe(3);
+    expect(callers[0].uuid).toBe('c');
+    expect(callers[0].hold_time).toBe('2:0');
+
+    sources[0].emit('delta', {seq: 12, queue: 'support', type: 'caller', key: 'a', data: caller('a', now - 75, true)});
+    expect(callers[1].uuid).toBe('a');
+    expect(callers[1].hold_time).toBeUndefined();
+
+    sources[0].emit('delta', {seq: 13, queue: 'support', type: 'caller', key: 'c', data: null});
+    expect(callers.length).toBe(2);
+    expect(callers[1]).toBe(untouched);
+    expect(scope.queues.support.callers).toBe(callers);
+  });
+
+  it('should keep the snapshot when the queue list arrives after it', function () {
+    sources[0].emit('snapshot', snapshot());
+    $httpBackend.flush();
+    expect(scope.queues.support.callers.length).toBe(2);
+    sources[0].emit('delta', {seq: 11, queue: 'support', type: 'caller', key: 'c', data: caller('c', now - 5)});
+    expect(scope.queues.support.callers.length).toBe(3);
+  });
+
+  it('should create queues first seen in a delta', function () {
+    sources[0].emit('snapshot', snapshot());
+    sources[0].emit('delta', {seq: 11, queue: 'sales', type: 'caller', key: 'd', data: caller('d', now - 5)});
+    expect(scope.queues.sales.callers[0].uuid).toBe('d');
+  });
+
+  it('should update hold times without rebuilding the queues', function () {
+    sources[0].emit('snapshot', snapshot());
+    var queues = scope.queues,
+      call = scope.queues.support.callers[0];
+    Date.now.andReturn((now + 10) * 1000);
+    $timeout.flush(1000);
+    expect(scope.queues).toBe(queues);
+    expect(scope.queues.support.callers[0]).toBe(call);
+    expect(call.hold_time).toBe('1:25');
+  });
+
+  it('should poll and retry the stream when it closes', function () {
+    spyOn(window, 'setTimeout');
+    sources[0].readyState = FakeEventSource.CLOSED;
+    sources[0].onerror();
+    $httpBackend.flush();
+    expect(scope.live).toBe(false);
+    expect(scope.queues.polled).toBeDefined();
+
+    $timeout.flush(5000);
+    expect(sources.length).toBe(2);
+    sources[1].readyState = FakeEventSource.CLOSED;
+    sources[1].onerror();
+    $timeout.flush(5000);
+    expect(sources.length).toBe(2);
+    $timeout.flush(5000);
+    expect(sources.length).toBe(3);
+    // Only one polling loop however often the stream fails
+    expect(window.setTimeout.callCount).toBe(1);
+
+    sources[2].emit('snapshot', snapshot());
+    expect(scope.live).toBe(true);
+    expect(scope.queues.support).toBeDefined();
+  });
+});